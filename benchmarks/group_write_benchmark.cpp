@@ -0,0 +1,123 @@
+#include "SerialPort.h"
+#include <iostream>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Compares a loop of write(data, true) with SerialPort::writeGroup on N
+// pseudo terminal pairs and reports the spread between the first and last
+// port to complete. Pseudo terminals have no wire time, so the numbers show
+// software overhead only; on real UARTs the loop spread grows by roughly one
+// packet transmission time per port. Usage: group_write_benchmark [ports] [rounds]
+
+typedef std::chrono::steady_clock Clock;
+
+struct Spread {
+    double totalUs;
+    double spreadUs;
+};
+
+static Spread measure(Clock::time_point start, const std::vector<Clock::time_point>& done) {
+    Clock::time_point first = done.front();
+    Clock::time_point last = done.front();
+    for (size_t i = 1; i < done.size(); ++i) {
+        if (done[i] < first) first = done[i];
+        if (done[i] > last) last = done[i];
+    }
+    Spread spread;
+    spread.totalUs = std::chrono::duration<double, std::micro>(last - start).count();
+    spread.spreadUs = std::chrono::duration<double, std::micro>(last - first).count();
+    return spread;
+}
+
+static void discardOutput(const std::vector<int>& masters) {
+    char buffer[1024];
+    for (size_t i = 0; i < masters.size(); ++i) {
+        while (::read(masters[i], buffer, sizeof(buffer)) > 0) {
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int portCount = argc > 1 ? std::atoi(argv[1]) : 24;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 100;
+    if (portCount <= 0 || rounds <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [ports] [rounds]" << std::endl;
+        return 1;
+    }
+
+    std::vector<int> masters;
+    std::vector<std::unique_ptr<Serial::SerialPort> > serials;
+    std::vector<Serial::SerialPort*> ports;
+
+    for (int i = 0; i < portCount; ++i) {
+        int master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (master == -1 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            std::cerr << "Unable to create pseudo terminal: " << strerror(errno) << std::endl;
+            return 1;
+        }
+        masters.push_back(master);
+
+        std::unique_ptr<Serial::SerialPort> serial(new Serial::SerialPort());
+        if (!serial->open(ptsname(master)) || !serial->apply(Serial::Profile8N1_921600())) {
+            std::cerr << "Unable to set up " << ptsname(master) << ": "
+                      << serial->getLastError() << std::endl;
+            return 1;
+        }
+        ports.push_back(serial.get());
+        serials.push_back(std::move(serial));
+    }
+
+    const std::string packet = "SYNC:0123456789\n";
+    double loopTotal = 0, loopSpread = 0;
+    double groupTotal = 0, groupSpread = 0;
+
+    for (int r = 0; r < rounds; ++r) {
+        // Sequential writes, each waiting for its own drain
+        std::vector<Clock::time_point> done(ports.size());
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < ports.size(); ++i) {
+            if (ports[i]->write(packet, true) != static_cast<int>(packet.size())) {
+                std::cerr << "Write failed: " << ports[i]->getLastError() << std::endl;
+                return 1;
+            }
+            done[i] = Clock::now();
+        }
+        Spread loop = measure(start, done);
+        loopTotal += loop.totalUs;
+        loopSpread += loop.spreadUs;
+        discardOutput(masters);
+
+        // One batch across all ports
+        start = Clock::now();
+        std::vector<Serial::GroupWriteResult> results = Serial::SerialPort::writeGroup(ports, packet);
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (!results[i].completed) {
+                std::cerr << "Group write failed on port " << i << ": " << results[i].error << std::endl;
+                return 1;
+            }
+            done[i] = results[i].completedAt;
+        }
+        Spread group = measure(start, done);
+        groupTotal += group.totalUs;
+        groupSpread += group.spreadUs;
+        discardOutput(masters);
+    }
+
+    std::cout << portCount << " ports, " << rounds << " rounds, "
+              << packet.size() << " byte packet" << std::endl;
+    std::cout << "write(data, true) loop : total " << loopTotal / rounds
+              << " us, first-to-last spread " << loopSpread / rounds << " us" << std::endl;
+    std::cout << "writeGroup()           : total " << groupTotal / rounds
+              << " us, first-to-last spread " << groupSpread / rounds << " us" << std::endl;
+
+    serials.clear();
+    for (size_t i = 0; i < masters.size(); ++i) {
+        ::close(masters[i]);
+    }
+    return 0;
+}
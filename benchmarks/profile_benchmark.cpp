@@ -0,0 +1,92 @@
+#include "SerialPort.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Measures configure() against apply(profile) on a pseudo terminal,
+// so no serial hardware is required. 8N1 profiles are timed because
+// some pseudo terminal drivers reject parity changes.
+
+typedef Serial::ProfileModbus8E1_19200 ModbusProfile;
+
+static_assert(ModbusProfile::bitsPerCharacter == 11, "8E1 uses 11 bits per character");
+static_assert(ModbusProfile::t35Ns == ModbusProfile::characterTimeNs * 7 / 2, "t3.5 scales with character time up to 19200 baud");
+static_assert(Serial::Profile8N1_921600::t35Ns == 1750000, "t3.5 is fixed above 19200 baud");
+
+template <typename Func>
+static double averageMicroseconds(int iterations, Func func) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        if (!func()) {
+            return -1.0;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+int main() {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master == -1 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        std::cerr << "Unable to create pseudo terminal: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    std::string device = ptsname(master);
+
+    Serial::SerialPort serial;
+    Serial::SerialPort second;
+    if (!serial.open(device) || !second.open(device)) {
+        std::cerr << "Unable to open " << device << ": " << serial.getLastError()
+                  << second.getLastError() << std::endl;
+        ::close(master);
+        return 1;
+    }
+
+    std::cout << "Profile 8E1@19200: character time " << ModbusProfile::characterTimeNs
+              << " ns, t1.5 " << ModbusProfile::t15Ns
+              << " ns, t3.5 " << ModbusProfile::t35Ns << " ns" << std::endl;
+
+    const int slowIterations = 10;
+    const int fastIterations = 100000;
+
+    double configureUs = averageMicroseconds(slowIterations, [&]() {
+        return serial.configure(Serial::BaudRate::BAUD_115200);
+    });
+
+    // Alternate between two profiles so every call has to reprogram the port
+    bool toggle = false;
+    double switchUs = averageMicroseconds(slowIterations, [&]() {
+        toggle = !toggle;
+        return toggle ? serial.apply(Serial::Profile8N1_921600())
+                      : serial.apply(Serial::Profile8N1_115200());
+    });
+
+    // Port already matches, attributes are only read and compared
+    double matchUs = averageMicroseconds(fastIterations, [&]() {
+        return serial.apply(Serial::Profile8N1_115200());
+    });
+
+    // Another handle on the same device sees the settings as matching too
+    double otherHandleUs = averageMicroseconds(fastIterations, [&]() {
+        return second.apply(Serial::Profile8N1_115200());
+    });
+
+    if (configureUs < 0 || switchUs < 0 || matchUs < 0 || otherHandleUs < 0) {
+        std::cerr << "Benchmark failed: " << serial.getLastError() << second.getLastError() << std::endl;
+        ::close(master);
+        return 1;
+    }
+
+    std::cout << "configure()                  : " << configureUs << " us" << std::endl;
+    std::cout << "apply() switching profiles   : " << switchUs << " us" << std::endl;
+    std::cout << "apply() port already matches : " << matchUs << " us" << std::endl;
+    std::cout << "apply() from another handle  : " << otherHandleUs << " us" << std::endl;
+
+    serial.close();
+    second.close();
+    ::close(master);
+    return 0;
+}
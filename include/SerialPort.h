@@ -1,6 +1,10 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <cstdint>
 #include <termios.h>
 
 namespace Serial {
@@ -40,6 +44,117 @@ enum class FlowControl : tcflag_t {
     SOFTWARE = IXON | IXOFF
 };
 
+// Numeric value of a baud rate, usable in constant expressions
+constexpr uint32_t baudRateValue(BaudRate baudRate) {
+    return baudRate == BaudRate::BAUD_9600   ? 9600u :
+           baudRate == BaudRate::BAUD_19200  ? 19200u :
+           baudRate == BaudRate::BAUD_38400  ? 38400u :
+           baudRate == BaudRate::BAUD_57600  ? 57600u :
+           baudRate == BaudRate::BAUD_115200 ? 115200u :
+           baudRate == BaudRate::BAUD_230400 ? 230400u :
+           baudRate == BaudRate::BAUD_460800 ? 460800u : 921600u;
+}
+
+// Number of data bits in a character
+constexpr uint32_t dataBitsValue(DataBits dataBits) {
+    return dataBits == DataBits::BITS_5 ? 5u :
+           dataBits == DataBits::BITS_6 ? 6u :
+           dataBits == DataBits::BITS_7 ? 7u : 8u;
+}
+
+// Fixed port configuration resolved at compile time.
+// Flag words and timing constants are constant expressions; the termios
+// image is built once per profile and shared by every port applying it.
+template <BaudRate Baud,
+          DataBits Bits = DataBits::BITS_8,
+          Parity Par = Parity::NONE,
+          StopBits Stop = StopBits::ONE,
+          FlowControl Flow = FlowControl::NONE>
+struct PortProfile {
+    static constexpr uint32_t baudRate = baudRateValue(Baud);
+
+    // Start bit + data bits + parity bit + stop bits
+    static constexpr uint32_t bitsPerCharacter =
+        1u + dataBitsValue(Bits) + (Par == Parity::NONE ? 0u : 1u) +
+        (Stop == StopBits::TWO ? 2u : 1u);
+
+    // Time to transmit one character on the wire, in nanoseconds
+    static constexpr uint64_t characterTimeNs =
+        (static_cast<uint64_t>(bitsPerCharacter) * 1000000000ull + baudRate - 1) / baudRate;
+
+    // Modbus RTU inter-character (t1.5) and inter-frame (t3.5) timeouts.
+    // Above 19200 baud the specification fixes them at 750us and 1750us.
+    static constexpr uint64_t t15Ns = baudRate > 19200u ? 750000ull : characterTimeNs * 3 / 2;
+    static constexpr uint64_t t35Ns = baudRate > 19200u ? 1750000ull : characterTimeNs * 7 / 2;
+
+    // Flag words without the baud rate bits, matching configure()
+    static constexpr tcflag_t controlFlags =
+        static_cast<tcflag_t>(Bits) |
+        (Par == Parity::EVEN ? static_cast<tcflag_t>(PARENB) : 0) |
+        (Par == Parity::ODD ? static_cast<tcflag_t>(PARENB | PARODD) : 0) |
+        static_cast<tcflag_t>(Stop) |
+        (Flow == FlowControl::HARDWARE ? static_cast<tcflag_t>(CRTSCTS) : 0) |
+        CLOCAL | CREAD;
+    static constexpr tcflag_t inputFlags =
+        Flow == FlowControl::SOFTWARE ? static_cast<tcflag_t>(IXON | IXOFF) : 0;
+    static constexpr tcflag_t outputFlags = 0;
+    static constexpr tcflag_t localFlags = 0;
+
+    // Complete termios image for this profile
+    static const struct termios& terminalImage() {
+        static const struct termios image = buildTermios();
+        return image;
+    }
+
+private:
+    static struct termios buildTermios() {
+        struct termios options = {};
+        options.c_cflag = controlFlags;
+        options.c_iflag = inputFlags;
+        options.c_oflag = outputFlags;
+        options.c_lflag = localFlags;
+        cfsetispeed(&options, static_cast<speed_t>(Baud));
+        cfsetospeed(&options, static_cast<speed_t>(Baud));
+        options.c_cc[VTIME] = 10;  // 1 second timeout
+        options.c_cc[VMIN] = 0;    // Non-blocking read
+        options.c_cc[VSTART] = 0x11;  // XON, NUL would otherwise act as flow control
+        options.c_cc[VSTOP] = 0x13;   // XOFF
+        return options;
+    }
+};
+
+template <BaudRate Baud, DataBits Bits, Parity Par, StopBits Stop, FlowControl Flow>
+constexpr uint32_t PortProfile<Baud, Bits, Par, Stop, Flow>::baudRate;
+template <BaudRate Baud, DataBits Bits, Parity Par, StopBits Stop, FlowControl Flow>
+constexpr uint32_t PortProfile<Baud, Bits, Par, Stop, Flow>::bitsPerCharacter;
+template <BaudRate Baud, DataBits Bits, Parity Par, StopBits Stop, FlowControl Flow>
+constexpr uint64_t PortProfile<Baud, Bits, Par, Stop, Flow>::characterTimeNs;
+template <BaudRate Baud, DataBits Bits, Parity Par, StopBits Stop, FlowControl Flow>
+constexpr uint64_t PortProfile<Baud, Bits, Par, Stop, Flow>::t15Ns;
+template <BaudRate Baud, DataBits Bits, Parity Par, StopBits Stop, FlowControl Flow>
+constexpr uint64_t PortProfile<Baud, Bits, Par, Stop, Flow>::t35Ns;
+template <BaudRate Baud, DataBits Bits, Parity Par, StopBits Stop, FlowControl Flow>
+constexpr tcflag_t PortProfile<Baud, Bits, Par, Stop, Flow>::controlFlags;
+template <BaudRate Baud, DataBits Bits, Parity Par, StopBits Stop, FlowControl Flow>
+constexpr tcflag_t PortProfile<Baud, Bits, Par, Stop, Flow>::inputFlags;
+template <BaudRate Baud, DataBits Bits, Parity Par, StopBits Stop, FlowControl Flow>
+constexpr tcflag_t PortProfile<Baud, Bits, Par, Stop, Flow>::outputFlags;
+template <BaudRate Baud, DataBits Bits, Parity Par, StopBits Stop, FlowControl Flow>
+constexpr tcflag_t PortProfile<Baud, Bits, Par, Stop, Flow>::localFlags;
+
+// Common profiles
+typedef PortProfile<BaudRate::BAUD_115200> Profile8N1_115200;
+typedef PortProfile<BaudRate::BAUD_921600> Profile8N1_921600;
+typedef PortProfile<BaudRate::BAUD_19200, DataBits::BITS_8, Parity::EVEN> ProfileModbus8E1_19200;
+
+// Per-port outcome of SerialPort::writeGroup
+struct GroupWriteResult {
+    int bytesWritten = 0;       // Bytes accepted by the port, -1 if an error left none
+    bool completed = false;     // All bytes written (and drained if requested)
+    std::chrono::steady_clock::time_point completedAt;  // When the port finished
+    std::string error;          // Error message if not completed
+};
+
 class SerialPort {
 public:
     SerialPort();
@@ -61,6 +176,14 @@ public:
                   StopBits stopBits = StopBits::ONE,
                   FlowControl flowControl = FlowControl::NONE);
     
+    // Apply a precomputed profile. The port's current attributes are read
+    // first and only set if the flags, speed, VMIN or XON/XOFF characters
+    // differ; settings the driver does not accept are reported as an error.
+    template <typename Profile>
+    bool apply(const Profile&) {
+        return applyTerminalImage(Profile::terminalImage());
+    }
+    
     // Write data
     int write(const void* data, size_t size);
     int write(const std::string& data);
@@ -69,6 +192,28 @@ public:
     int write(const void* data, size_t size, bool waitForCompletion);
     int write(const std::string& data, bool waitForCompletion);
     
+    // Write the same buffer to many ports in one batch. Writes are swept
+    // non-blocking across all ports and, if requested, drain completion is
+    // polled for all ports at once. A non-negative timeoutMs bounds writing
+    // and draining; the default waits as long as write(data, true) would.
+    // Closed ports and ports listed more than once fail without being written.
+    static std::vector<GroupWriteResult> writeGroup(const std::vector<SerialPort*>& ports,
+                                                    const void* data, size_t size,
+                                                    bool waitForCompletion = true,
+                                                    int timeoutMs = -1);
+    static std::vector<GroupWriteResult> writeGroup(const std::vector<SerialPort*>& ports,
+                                                    const std::string& data,
+                                                    bool waitForCompletion = true,
+                                                    int timeoutMs = -1);
+    
+    // Write one buffer per port (buffers[i] goes to ports[i]) in one batch.
+    // Ports without a buffer fail without being written. Extra buffers fail
+    // the whole call, with one extra result per buffer that has no port.
+    static std::vector<GroupWriteResult> writeGroup(const std::vector<SerialPort*>& ports,
+                                                    const std::vector<std::string>& buffers,
+                                                    bool waitForCompletion = true,
+                                                    int timeoutMs = -1);
+    
     // Read data with timeout
     int read(void* buffer, size_t size, int timeoutMs = 1000);
     std::string read(size_t maxBytes = 1024, int timeoutMs = 1000);
@@ -94,6 +239,15 @@ private:
     
     // Helper functions
     bool setTerminalAttributes(const struct termios& options);
+    bool applyTerminalImage(const struct termios& image);
+    static std::string terminalImageMismatch(const struct termios& current,
+                                             const struct termios& image);
+    static void writeGroupBuffers(const std::vector<SerialPort*>& ports,
+                                  const std::vector<std::pair<const char*, size_t> >& buffers,
+                                  const std::vector<bool>& skip,
+                                  bool waitForCompletion, int timeoutMs,
+                                  std::vector<GroupWriteResult>& results);
+    static int64_t characterTimeNs(int fd);
     bool setReadTimeout(int timeoutMs);
     void setError(const std::string& error);
 };
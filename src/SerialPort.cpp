@@ -2,8 +2,11 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
 #include <cstring>
 #include <errno.h>
+#include <set>
+#include <algorithm>
 
 namespace Serial {
 
@@ -121,13 +124,6 @@ bool SerialPort::configure(BaudRate baudRate, DataBits dataBits, Parity parity,
         options.c_cflag |= CSTOPB;
     }
     
-    // Set flow control
-    if (flowControl == FlowControl::HARDWARE) {
-        options.c_cflag |= CRTSCTS;
-    } else if (flowControl == FlowControl::SOFTWARE) {
-        options.c_iflag |= IXON | IXOFF;
-    }
-    
     // Enable receiver, set local mode
     options.c_cflag |= CLOCAL | CREAD;
     
@@ -136,6 +132,15 @@ bool SerialPort::configure(BaudRate baudRate, DataBits dataBits, Parity parity,
     options.c_oflag &= ~OPOST;
     options.c_iflag &= ~(IXON | IXOFF | IXANY | ICRNL | INLCR | IGNCR);
     
+    // Set flow control (after raw mode, which clears IXON/IXOFF)
+    if (flowControl == FlowControl::HARDWARE) {
+        options.c_cflag |= CRTSCTS;
+    } else if (flowControl == FlowControl::SOFTWARE) {
+        options.c_iflag |= IXON | IXOFF;
+        options.c_cc[VSTART] = 0x11;  // XON
+        options.c_cc[VSTOP] = 0x13;   // XOFF
+    }
+    
     // Set default timeout and minimum character count
     options.c_cc[VTIME] = 10;  // 1 second timeout
     options.c_cc[VMIN] = 0;    // Non-blocking read
@@ -179,6 +184,338 @@ int SerialPort::write(const std::string& data, bool waitForCompletion) {
     return write(data.c_str(), data.size(), waitForCompletion);
 }
 
+std::vector<GroupWriteResult> SerialPort::writeGroup(const std::vector<SerialPort*>& ports,
+                                                     const void* data, size_t size,
+                                                     bool waitForCompletion, int timeoutMs) {
+    std::vector<std::pair<const char*, size_t> > buffers(
+        ports.size(), std::make_pair(static_cast<const char*>(data), size));
+    std::vector<GroupWriteResult> results(ports.size());
+    writeGroupBuffers(ports, buffers, std::vector<bool>(ports.size(), false),
+                      waitForCompletion, timeoutMs, results);
+    return results;
+}
+
+std::vector<GroupWriteResult> SerialPort::writeGroup(const std::vector<SerialPort*>& ports,
+                                                     const std::string& data,
+                                                     bool waitForCompletion, int timeoutMs) {
+    return writeGroup(ports, data.c_str(), data.size(), waitForCompletion, timeoutMs);
+}
+
+std::vector<GroupWriteResult> SerialPort::writeGroup(const std::vector<SerialPort*>& ports,
+                                                     const std::vector<std::string>& buffers,
+                                                     bool waitForCompletion, int timeoutMs) {
+    // One result per port, plus one per buffer that has no port
+    std::vector<GroupWriteResult> results(std::max(ports.size(), buffers.size()));
+    
+    if (buffers.size() > ports.size()) {
+        for (size_t i = 0; i < results.size(); ++i) {
+            results[i].bytesWritten = -1;
+            results[i].error = i < ports.size() ? "More buffers than ports in group write"
+                                                : "No port provided for buffer";
+            if (i < ports.size() && ports[i]) {
+                ports[i]->setError(results[i].error);
+            }
+        }
+        return results;
+    }
+    
+    std::vector<std::pair<const char*, size_t> > views(
+        ports.size(), std::make_pair(static_cast<const char*>(nullptr), size_t(0)));
+    std::vector<bool> skip(ports.size(), false);
+    
+    for (size_t i = 0; i < ports.size(); ++i) {
+        if (i < buffers.size()) {
+            views[i] = std::make_pair(buffers[i].c_str(), buffers[i].size());
+            continue;
+        }
+        
+        // Ports without a buffer are left untouched by the batch
+        skip[i] = true;
+        results[i].bytesWritten = -1;
+        results[i].error = "No buffer provided for port";
+        if (ports[i]) {
+            ports[i]->setError(results[i].error);
+        }
+    }
+    
+    writeGroupBuffers(ports, views, skip, waitForCompletion, timeoutMs, results);
+    return results;
+}
+
+void SerialPort::writeGroupBuffers(const std::vector<SerialPort*>& ports,
+                                   const std::vector<std::pair<const char*, size_t> >& buffers,
+                                   const std::vector<bool>& skip,
+                                   bool waitForCompletion, int timeoutMs,
+                                   std::vector<GroupWriteResult>& results) {
+    typedef std::chrono::steady_clock Clock;
+    enum PortState { SKIPPED, FAILED, WRITING, DRAINING, DONE };
+    
+    const size_t count = ports.size();
+    std::vector<PortState> states(count, WRITING);
+    std::vector<int> savedFlags(count, -1);
+    std::vector<size_t> offsets(count, 0);
+    std::vector<int64_t> charTimeNs(count, 0);
+    
+    // Bytes that already went out are still reported after a failure
+    auto fail = [&](size_t i, const std::string& error) {
+        results[i].bytesWritten = offsets[i] > 0 || states[i] == DRAINING
+            ? static_cast<int>(offsets[i]) : -1;
+        states[i] = FAILED;
+        results[i].error = error;
+        if (ports[i]) {
+            ports[i]->setError(error);
+        }
+    };
+    
+    // Push as much data as the port accepts without blocking
+    auto writeSome = [&](size_t i) {
+        while (offsets[i] < buffers[i].second) {
+            ssize_t result = ::write(ports[i]->fd_, buffers[i].first + offsets[i],
+                                     buffers[i].second - offsets[i]);
+            if (result == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                fail(i, "Failed to write data: " + std::string(strerror(errno)));
+                return;
+            }
+            offsets[i] += static_cast<size_t>(result);
+            results[i].bytesWritten = static_cast<int>(offsets[i]);
+        }
+        results[i].completedAt = Clock::now();
+        states[i] = waitForCompletion ? DRAINING : DONE;
+    };
+    
+    // Poll a port whose data has been written. Returns the estimated time
+    // until it finishes, or 0 once it is no longer draining. Once the driver
+    // queue is empty, UARTs report the transmitter state through the line
+    // status register. Other drivers finish with tcdrain(), which also waits
+    // for their own transmit FIFOs; with the queue empty this is brief unless
+    // flow control holds the FIFO, and it is not bounded by the timeout.
+    auto checkDrained = [&](size_t i) -> int64_t {
+        int queued = 0;
+        if (ioctl(ports[i]->fd_, TIOCOUTQ, &queued) == -1) {
+            fail(i, "Data written but failed to wait for transmission completion: " +
+                    std::string(strerror(errno)));
+            return 0;
+        }
+        if (queued > 0) {
+            return queued * charTimeNs[i];
+        }
+        
+        unsigned int lineStatus = 0;
+        if (ioctl(ports[i]->fd_, TIOCSERGETLSR, &lineStatus) == -1) {
+            if (errno != ENOTTY && errno != EINVAL) {
+                fail(i, "Data written but failed to wait for transmission completion: " +
+                        std::string(strerror(errno)));
+                return 0;
+            }
+            if (tcdrain(ports[i]->fd_) != 0) {
+                fail(i, "Data written but failed to wait for transmission completion: " +
+                        std::string(strerror(errno)));
+                return 0;
+            }
+            results[i].completedAt = Clock::now();
+            states[i] = DONE;
+            return 0;
+        }
+        if (!(lineStatus & TIOCSER_TEMT)) {
+            return charTimeNs[i];
+        }
+        
+        results[i].completedAt = Clock::now();
+        states[i] = DONE;
+        return 0;
+    };
+    
+    // Reject closed ports and any port listed more than once, since the
+    // saved file status flags are per file descriptor
+    std::set<int> seen;
+    for (size_t i = 0; i < count; ++i) {
+        if (skip[i]) {
+            states[i] = SKIPPED;
+        } else if (!ports[i] || !ports[i]->isOpen()) {
+            fail(i, "Serial port is not open");
+        } else if (!seen.insert(ports[i]->fd_).second) {
+            fail(i, "Serial port appears more than once in group write");
+        } else if (waitForCompletion) {
+            charTimeNs[i] = characterTimeNs(ports[i]->fd_);
+        }
+    }
+    
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        std::string error = "Unable to create epoll instance: " + std::string(strerror(errno));
+        for (size_t i = 0; i < count; ++i) {
+            if (states[i] == WRITING) {
+                fail(i, error);
+            }
+        }
+        return;
+    }
+    
+    // Switch every port to non-blocking mode for the write sweep
+    for (size_t i = 0; i < count; ++i) {
+        if (states[i] != WRITING) {
+            continue;
+        }
+        
+        int flags = fcntl(ports[i]->fd_, F_GETFL);
+        if (flags == -1) {
+            fail(i, "Unable to get file status flags: " + std::string(strerror(errno)));
+            continue;
+        }
+        if (fcntl(ports[i]->fd_, F_SETFL, flags | O_NONBLOCK) == -1) {
+            fail(i, "Unable to set non-blocking mode: " + std::string(strerror(errno)));
+            continue;
+        }
+        savedFlags[i] = flags;
+    }
+    
+    // First sweep, then watch ports whose output queue was full
+    size_t writing = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (states[i] != WRITING) {
+            continue;
+        }
+        writeSome(i);
+        if (states[i] != WRITING) {
+            continue;
+        }
+        
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLOUT;
+        event.data.u64 = i;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, ports[i]->fd_, &event) == -1) {
+            fail(i, "Unable to watch serial port: " + std::string(strerror(errno)));
+            continue;
+        }
+        ++writing;
+    }
+    
+    // Finish writes and poll drain completion against one deadline;
+    // a negative timeout waits without limit
+    const bool hasDeadline = timeoutMs >= 0;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(hasDeadline ? timeoutMs : 0);
+    std::vector<struct epoll_event> events(count > 0 ? count : 1);
+    
+    while (true) {
+        // Shortest estimated time until a draining port finishes
+        int64_t nextCheckNs = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (states[i] == DRAINING) {
+                int64_t estimateNs = checkDrained(i);
+                if (states[i] == DRAINING && (nextCheckNs == 0 || estimateNs < nextCheckNs)) {
+                    nextCheckNs = estimateNs;
+                }
+            }
+        }
+        
+        Clock::time_point now = Clock::now();
+        if ((writing == 0 && nextCheckNs == 0) || (hasDeadline && now >= deadline)) {
+            break;
+        }
+        
+        Clock::duration wait = nextCheckNs > 0
+            ? Clock::duration(std::chrono::nanoseconds(std::max<int64_t>(nextCheckNs, 50000)))
+            : Clock::duration::max();
+        if (hasDeadline && deadline - now < wait) {
+            wait = deadline - now;
+        }
+        
+        if (writing > 0) {
+            // epoll counts in whole milliseconds, so round up to avoid spinning
+            int timeout = -1;
+            if (wait != Clock::duration::max()) {
+                auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    wait + std::chrono::milliseconds(1) - Clock::duration(1)).count();
+                timeout = static_cast<int>(std::min<int64_t>(waitMs, 1000000));
+            }
+            
+            int ready = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), timeout);
+            if (ready == -1 && errno != EINTR) {
+                std::string error = "Failed to wait for serial ports: " + std::string(strerror(errno));
+                for (size_t i = 0; i < count; ++i) {
+                    if (states[i] == WRITING) {
+                        fail(i, error);
+                    }
+                }
+                writing = 0;
+            }
+            
+            for (int e = 0; e < ready; ++e) {
+                size_t i = static_cast<size_t>(events[e].data.u64);
+                writeSome(i);
+                if (states[i] != WRITING) {
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, ports[i]->fd_, nullptr);
+                    --writing;
+                }
+            }
+        } else {
+            usleep(static_cast<useconds_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(wait).count()));
+        }
+    }
+    
+    ::close(epollFd);
+    
+    // Restore blocking mode and report ports that ran out of time
+    for (size_t i = 0; i < count; ++i) {
+        if (savedFlags[i] != -1) {
+            fcntl(ports[i]->fd_, F_SETFL, savedFlags[i]);
+        }
+        
+        if (states[i] == WRITING) {
+            results[i].error = "Timed out writing data";
+            ports[i]->setError(results[i].error);
+        } else if (states[i] == DRAINING) {
+            results[i].error = "Data written but timed out waiting for transmission completion";
+            ports[i]->setError(results[i].error);
+        }
+        if (states[i] != SKIPPED) {
+            results[i].completed = states[i] == DONE;
+        }
+    }
+}
+
+int64_t SerialPort::characterTimeNs(int fd) {
+    struct termios options;
+    if (tcgetattr(fd, &options) != 0) {
+        return 100000;  // Unknown line settings, poll every 100us
+    }
+    
+    static const struct {
+        speed_t speed;
+        int64_t baud;
+    } speeds[] = {
+        { B1200, 1200 }, { B2400, 2400 }, { B4800, 4800 }, { B9600, 9600 },
+        { B19200, 19200 }, { B38400, 38400 }, { B57600, 57600 },
+        { B115200, 115200 }, { B230400, 230400 }, { B460800, 460800 },
+        { B921600, 921600 }
+    };
+    
+    int64_t baud = 0;
+    speed_t speed = cfgetospeed(&options);
+    for (size_t i = 0; i < sizeof(speeds) / sizeof(speeds[0]); ++i) {
+        if (speeds[i].speed == speed) {
+            baud = speeds[i].baud;
+            break;
+        }
+    }
+    if (baud == 0) {
+        return 100000;
+    }
+    
+    tcflag_t size = options.c_cflag & CSIZE;
+    int64_t bits = 1 + (size == CS5 ? 5 : size == CS6 ? 6 : size == CS7 ? 7 : 8) +
+                   ((options.c_cflag & PARENB) ? 1 : 0) + ((options.c_cflag & CSTOPB) ? 2 : 1);
+    return (bits * 1000000000 + baud - 1) / baud;
+}
+
 bool SerialPort::drain() {
     if (!isOpen()) {
         setError("Serial port is not open");
@@ -317,6 +654,64 @@ bool SerialPort::setTerminalAttributes(const struct termios& options) {
     return true;
 }
 
+bool SerialPort::applyTerminalImage(const struct termios& image) {
+    if (!isOpen()) {
+        setError("Serial port is not open");
+        return false;
+    }
+    
+    struct termios current;
+    if (tcgetattr(fd_, &current) != 0) {
+        setError("Unable to get serial port attributes: " + std::string(strerror(errno)));
+        return false;
+    }
+    
+    if (terminalImageMismatch(current, image).empty()) {
+        return true;
+    }
+    
+    if (!setTerminalAttributes(image)) {
+        return false;
+    }
+    
+    // tcsetattr() succeeds if any change was applied, so confirm the driver took all of them
+    if (tcgetattr(fd_, &current) != 0) {
+        setError("Unable to get serial port attributes: " + std::string(strerror(errno)));
+        return false;
+    }
+    
+    std::string mismatch = terminalImageMismatch(current, image);
+    if (!mismatch.empty()) {
+        setError("Serial port did not accept profile settings: " + mismatch);
+        return false;
+    }
+    
+    return true;
+}
+
+std::string SerialPort::terminalImageMismatch(const struct termios& current,
+                                              const struct termios& image) {
+    // VTIME is ignored since read() adjusts it per call
+    std::string mismatch;
+    auto check = [&mismatch](bool same, const char* field) {
+        if (!same) {
+            mismatch += mismatch.empty() ? field : std::string(", ") + field;
+        }
+    };
+    
+    check(current.c_cflag == image.c_cflag, "control flags");
+    check(current.c_iflag == image.c_iflag, "input flags");
+    check(current.c_oflag == image.c_oflag, "output flags");
+    check(current.c_lflag == image.c_lflag, "local flags");
+    check(cfgetispeed(&current) == cfgetispeed(&image), "input speed");
+    check(cfgetospeed(&current) == cfgetospeed(&image), "output speed");
+    check(current.c_cc[VMIN] == image.c_cc[VMIN], "VMIN");
+    check(current.c_cc[VSTART] == image.c_cc[VSTART], "VSTART");
+    check(current.c_cc[VSTOP] == image.c_cc[VSTOP], "VSTOP");
+    
+    return mismatch;
+}
+
 bool SerialPort::setReadTimeout(int timeoutMs) {
     if (!isOpen()) {
         setError("Serial port is not open");